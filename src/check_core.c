@@ -0,0 +1,215 @@
+#include "chip8.h"
+#include <stdio.h>
+#include <string.h>
+
+// regression check for the core's safety guarantees: each out-of-range ROM
+// action must raise the right fault with the right PC, keep sp in range and
+// touch no memory other than its wrapped targets
+
+static ChipIn_t chip8;
+static uint8_t memory_before[MEMORY_SIZE];
+
+// fresh VM with one instruction at addr, ready to execute it
+static void setup(uint16_t addr, uint16_t instruction) {
+    chip8_init(&chip8);
+    chip8.memory[addr & MEMORY_MASK] = instruction >> 8;
+    chip8.memory[(addr + 1) & MEMORY_MASK] = instruction & 0xFF;
+    chip8.pc = addr;
+}
+
+static void snapshot_memory(void) {
+    memcpy(memory_before, chip8.memory, sizeof(memory_before));
+}
+
+static int expect(const char* name, bool ok, const char* what) {
+    if (!ok) {
+        fprintf(stderr, "%s: %s\n", name, what);
+        return 1;
+    }
+    return 0;
+}
+
+static int expect_fault(const char* name, uint8_t fault, uint16_t pc) {
+    int status = expect(name, chip8.faults == fault, "wrong fault flags");
+    if (fault) {
+        status |= expect(name, chip8_fault_pc(&chip8, fault) == pc, "wrong fault PC");
+    }
+    return status;
+}
+
+// memory matches the snapshot except at the listed (already wrapped) addresses
+static int expect_memory(const char* name, const uint16_t* written, int count) {
+    for (int addr = 0; addr < MEMORY_SIZE; addr++) {
+        bool allowed = false;
+        for (int i = 0; i < count; i++) {
+            allowed |= written[i] == addr;
+        }
+        if (!allowed && chip8.memory[addr] != memory_before[addr]) {
+            fprintf(stderr, "%s: memory at 0x%03X changed\n", name, addr);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_return_on_empty_stack(void) {
+    const char* name = "00EE on an empty stack";
+    setup(0x200, 0x00EE);
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    int status = expect_fault(name, FAULT_STACK_UNDERFLOW, 0x200);
+    status |= expect(name, chip8.sp == 0, "sp left 0");
+    status |= expect_memory(name, NULL, 0);
+    return status;
+}
+
+static int check_nested_calls(void) {
+    const char* name = "17 nested 2nnn calls";
+    chip8_init(&chip8);
+
+    // a chain of calls, each to the next instruction, then a return at 0x300
+    for (uint16_t addr = 0x200; addr < 0x200 + 2 * (STACK_DEPTH + 1); addr += 2) {
+        uint16_t call = 0x2000 | (addr + 2);
+        chip8.memory[addr] = call >> 8;
+        chip8.memory[addr + 1] = call & 0xFF;
+    }
+    chip8.memory[0x300] = 0x00;
+    chip8.memory[0x301] = 0xEE;
+    snapshot_memory();
+
+    int status = 0;
+    for (int i = 0; i < STACK_DEPTH; i++) {
+        chip8_execute_cycle(&chip8);
+    }
+    status |= expect(name, chip8.faults == 0, "fault before the stack was full");
+
+    uint16_t last_call = chip8.pc;
+    chip8_execute_cycle(&chip8);
+    status |= expect_fault(name, FAULT_STACK_OVERFLOW, last_call);
+    status |= expect(name, chip8.sp == STACK_DEPTH, "sp left STACK_DEPTH");
+    status |= expect_memory(name, NULL, 0);
+    chip8.faults = 0;
+
+    // the 16 valid frames unwind in order, then the stack is empty again
+    for (int i = STACK_DEPTH - 1; i >= 0; i--) {
+        chip8.pc = 0x300;
+        chip8_execute_cycle(&chip8);
+        if (chip8.pc != 0x202 + 2 * i) {
+            fprintf(stderr, "%s: return %d went to 0x%03X\n", name, STACK_DEPTH - i, chip8.pc);
+            status = 1;
+        }
+    }
+    status |= expect(name, chip8.faults == 0 && chip8.sp == 0, "unwinding the valid frames faulted");
+
+    chip8.pc = 0x300;
+    chip8_execute_cycle(&chip8);
+    status |= expect_fault(name, FAULT_STACK_UNDERFLOW, 0x300);
+    return status;
+}
+
+static int check_fetch_at_end(void) {
+    const char* name = "fetch at 0xFFF";
+    chip8_init(&chip8);
+    chip8.pc = 0xFFF;
+    chip8.memory[0xFFF] = 0x60; // LD V0, kk with kk wrapping to the font at 0x000
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    int status = expect_fault(name, FAULT_MEMORY, 0xFFF);
+    status |= expect(name, chip8.V[0] == chip8.memory[0], "second byte not read from 0x000");
+    status |= expect_memory(name, NULL, 0);
+    return status;
+}
+
+static int check_bcd_at_end(void) {
+    const char* name = "Fx33 with I at 0xFFE";
+    setup(0x200, 0xF533);
+    chip8.V[5] = 123;
+    chip8.I = 0xFFE;
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    const uint16_t written[] = {0xFFE, 0xFFF, 0x000};
+    int status = expect_fault(name, FAULT_MEMORY, 0x200);
+    status |= expect(name, chip8.memory[0xFFE] == 1 && chip8.memory[0xFFF] == 2 &&
+                           chip8.memory[0x000] == 3, "digits not wrapped");
+    status |= expect_memory(name, written, 3);
+    return status;
+}
+
+static int check_store_at_end(void) {
+    const char* name = "Fx55 with I at 0xFFE";
+    setup(0x200, 0xF355);
+    for (int i = 0; i < NUM_REGISTERS; i++) {
+        chip8.V[i] = 0xA0 + i;
+    }
+    chip8.I = 0xFFE;
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    const uint16_t written[] = {0xFFE, 0xFFF, 0x000, 0x001};
+    int status = expect_fault(name, FAULT_MEMORY, 0x200);
+    for (int i = 0; i < 4; i++) {
+        status |= expect(name, chip8.memory[written[i]] == 0xA0 + i, "registers not wrapped");
+    }
+    status |= expect_memory(name, written, 4);
+
+    // the last in-range store must not fault
+    setup(0x200, 0xF355);
+    chip8.I = MEMORY_SIZE - 4;
+    chip8_execute_cycle(&chip8);
+    status |= expect_fault("Fx55 ending at 0xFFF", 0, 0);
+    return status;
+}
+
+static int check_key_index(void) {
+    const char* name = "Ex9E with Vx=0x20";
+    setup(0x200, 0xE29E);
+    chip8.V[2] = 0x20;
+    chip8.keypad[0x20 & KEY_MASK] = 1;
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    int status = expect_fault(name, FAULT_KEY, 0x200);
+    status |= expect(name, chip8.pc == 0x204, "key index not wrapped");
+    status |= expect_memory(name, NULL, 0);
+    return status;
+}
+
+static int check_sprite_at_end(void) {
+    const char* name = "Dxyn with I at 0xFFD";
+    setup(0x200, 0xD015);       // 5 rows at (0, 0) read 0xFFD..0x001
+    chip8.I = 0xFFD;
+    chip8.memory[0xFFD] = 0x80;
+    snapshot_memory();
+    chip8_execute_cycle(&chip8);
+
+    int status = expect_fault(name, FAULT_MEMORY, 0x200);
+    status |= expect(name, chip8.video[0] != 0, "sprite not drawn");
+    status |= expect_memory(name, NULL, 0);
+
+    // clipped at the bottom edge, only the rows on screen are read
+    name = "clipped Dxyn with I at 0xFFE";
+    setup(0x200, 0xD015);
+    chip8.V[1] = VIDEO_HEIGHT - 2;
+    chip8.I = 0xFFE;
+    chip8_execute_cycle(&chip8);
+    status |= expect_fault(name, 0, 0);
+    return status;
+}
+
+int main(void) {
+    int status = check_return_on_empty_stack();
+    status |= check_nested_calls();
+    status |= check_fetch_at_end();
+    status |= check_bcd_at_end();
+    status |= check_store_at_end();
+    status |= check_key_index();
+    status |= check_sprite_at_end();
+
+    if (status == 0) {
+        printf("Core fault handling OK\n");
+    }
+    return status;
+}
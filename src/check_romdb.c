@@ -0,0 +1,74 @@
+#include "chip8.h"
+#include "romdb.h"
+#include "test_rom.h"
+#include <stdio.h>
+#include <string.h>
+
+// build check for the embedded ROM database:
+//   1. src/romdb_builtin.c matches the text database it was generated from
+//   2. the Pico's built-in test ROM is found in it with the intended settings
+
+static int check_builtin_matches(const char* db_path) {
+    if (!romdb_load_file(db_path)) {
+        fprintf(stderr, "Failed to load ROM database: %s\n", db_path);
+        return 1;
+    }
+
+    size_t count;
+    const RomDbRecord_t* records = romdb_entries(&count);
+    int status = 0;
+
+    if (count != romdb_builtin_count) {
+        fprintf(stderr, "%s has %zu entries but romdb_builtin.c has %zu; "
+                        "rerun `chipin_romdb compile`\n", db_path, count, romdb_builtin_count);
+        status = 1;
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            const RomDbRecord_t* a = &records[i];
+            const RomDbRecord_t* b = &romdb_builtin[i];
+            if (a->hash != b->hash || a->cycles_per_frame != b->cycles_per_frame ||
+                a->quirks != b->quirks || a->scale != b->scale ||
+                memcmp(a->palette, b->palette, sizeof(a->palette)) != 0 ||
+                memcmp(a->keymap, b->keymap, sizeof(a->keymap)) != 0) {
+                fprintf(stderr, "romdb_builtin.c entry %016llx is out of date; "
+                                "rerun `chipin_romdb compile`\n", (unsigned long long)a->hash);
+                status = 1;
+            }
+        }
+    }
+
+    romdb_unload();
+    return status;
+}
+
+static int check_test_rom(void) {
+    ChipIn_t chip8;
+    chip8_init(&chip8);
+    chip8_configure_rom(&chip8, test_rom, sizeof(test_rom));
+
+    if (chip8.config.cycles_per_frame != TEST_ROM_CYCLES_PER_FRAME) {
+        fprintf(stderr, "test ROM %016llx not found in the built-in database "
+                        "(got %u cycles per frame, expected %u)\n",
+                (unsigned long long)chip8.rom_hash, chip8.config.cycles_per_frame,
+                TEST_ROM_CYCLES_PER_FRAME);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <database.txt>\n", argv[0]);
+        return 1;
+    }
+
+    // builtin lookup first, before a loaded text database could shadow it
+    int status = check_test_rom();
+    status |= check_builtin_matches(argv[1]);
+
+    if (status == 0) {
+        printf("ROM database OK (%zu built-in entries)\n", romdb_builtin_count);
+    }
+    return status;
+}
@@ -1,9 +1,16 @@
 #include "chip8.h"
+#include "romdb.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+_Static_assert((MEMORY_SIZE & MEMORY_MASK) == 0, "memory size must be a power of two");
+_Static_assert((STACK_DEPTH & STACK_MASK) == 0, "stack depth must be a power of two");
+_Static_assert((NUM_KEYS & KEY_MASK) == 0, "key count must be a power of two");
+_Static_assert((VIDEO_WIDTH & VIDEO_X_MASK) == 0 && (VIDEO_HEIGHT & VIDEO_Y_MASK) == 0,
+               "video dimensions must be powers of two");
+
 // CHIP-8 font set
 const uint8_t fontset[] = {
     0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
@@ -34,6 +41,14 @@ void chip8_init(ChipIn_t* cpu) {
     // set Program Counter to ROM start address
     cpu->pc = ROM_START_ADDRESS;
 
+    // default settings until a ROM database entry says otherwise
+    cpu->config.cycles_per_frame = DEFAULT_CYCLES_PER_FRAME;
+    cpu->config.palette[0] = 0x000000FF;
+    cpu->config.palette[1] = 0xFFFFFFFF;
+    for (int i = 0; i < NUM_KEYS; i++) {
+        cpu->config.keymap[i] = i;
+    }
+
     // seed the random number generator
     srand(time(NULL));
 }
@@ -49,6 +64,12 @@ bool chip8_load_rom(ChipIn_t* cpu, const char* filename) {
     long rom_size = ftell(rom_file);
     rewind(rom_file);
 
+    if (rom_size < 0) {
+        perror("Failed to size ROM");
+        fclose(rom_file);
+        return false;
+    }
+
     if (rom_size > (MEMORY_SIZE - ROM_START_ADDRESS)) {
         fprintf(stderr, "ROM file size is too large.\n");
         fclose(rom_file);
@@ -62,12 +83,80 @@ bool chip8_load_rom(ChipIn_t* cpu, const char* filename) {
     }
 
     fclose(rom_file);
+
+    chip8_configure_rom(cpu, &cpu->memory[ROM_START_ADDRESS], rom_size);
     return true;
 }
 
+void chip8_configure_rom(ChipIn_t* cpu, const uint8_t* rom, size_t size) {
+    cpu->rom_hash = romdb_hash(rom, size);
+    romdb_lookup(cpu->rom_hash, &cpu->config);
+}
+
+void chip8_set_keypad(ChipIn_t* cpu, const uint8_t* host_keys) {
+    memset(cpu->keypad, 0, sizeof(cpu->keypad));
+    for (int i = 0; i < NUM_KEYS; i++) {
+        cpu->keypad[cpu->config.keymap[i] & KEY_MASK] |= host_keys[i];
+    }
+}
+
+const char* chip8_fault_name(uint8_t fault) {
+    switch (fault) {
+        case FAULT_STACK_OVERFLOW: return "stack overflow";
+        case FAULT_STACK_UNDERFLOW: return "stack underflow";
+        case FAULT_MEMORY: return "memory access past 4KB";
+        case FAULT_KEY: return "invalid key index";
+        default: return "unknown fault";
+    }
+}
+
+// fault_pc slot of a single FAULT_* flag
+static inline int fault_index(uint8_t fault) {
+    switch (fault) {
+        case FAULT_STACK_OVERFLOW: return 0;
+        case FAULT_STACK_UNDERFLOW: return 1;
+        case FAULT_MEMORY: return 2;
+        default: return 3;
+    }
+}
+
+uint16_t chip8_fault_pc(const ChipIn_t* cpu, uint8_t fault) {
+    return cpu->fault_pc[fault_index(fault)];
+}
+
+// print one line per raised fault, then clear them for the next frame
+void chip8_report_faults(ChipIn_t* cpu, FILE* out, const char* prefix) {
+    for (uint8_t fault = 1; fault; fault <<= 1) {
+        if (cpu->faults & fault) {
+            fprintf(out, "%sROM fault at PC 0x%04X: %s\n", prefix, chip8_fault_pc(cpu, fault), chip8_fault_name(fault));
+        }
+    }
+    cpu->faults = 0;
+}
+
+// faults never happen in a well-behaved ROM, so keep their bookkeeping off
+// the straight-line path
+#if defined(__GNUC__) || defined(__clang__)
+#define UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define UNLIKELY(condition) (condition)
+#endif
+
+// record a fault: the flag is set without branching (the checks sit on the
+// hot path), the faulting address only on the cold path
+static inline void flag_fault(ChipIn_t* cpu, uint16_t pc, bool condition, uint8_t fault) {
+    cpu->faults |= (uint8_t)(condition * fault);
+    if (UNLIKELY(condition)) {
+        cpu->fault_pc[fault_index(fault)] = pc;
+    }
+}
+
 void chip8_execute_cycle(ChipIn_t* cpu) {
     // fetch instruction
-    uint16_t instruction = (cpu->memory[cpu->pc] << 8) | cpu->memory[cpu->pc + 1];
+    const uint16_t pc = cpu->pc;
+    flag_fault(cpu, pc, pc > MEMORY_SIZE - 2, FAULT_MEMORY);
+    uint16_t instruction = (cpu->memory[cpu->pc & MEMORY_MASK] << 8) |
+                           cpu->memory[(cpu->pc + 1) & MEMORY_MASK];
 
     // increment the program counter
     cpu->pc += 2;
@@ -88,8 +177,14 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
                     cpu->draw_flag = true;
                     break;
                 case 0x00EE: // RET - Return from subroutine
-                    cpu->sp--;
-                    cpu->pc = cpu->stack[cpu->sp];
+                    {
+                        // sp never leaves 0..STACK_DEPTH: a bad return faults and
+                        // reuses the bottom slot instead of wrapping the counter
+                        bool underflow = cpu->sp == 0;
+                        flag_fault(cpu, pc, underflow, FAULT_STACK_UNDERFLOW);
+                        cpu->sp -= !underflow;
+                        cpu->pc = cpu->stack[cpu->sp & STACK_MASK];
+                    }
                     break;
                 default:
                     // SYS nnn - Jump to machine code routine (ignored in modern interpreters)
@@ -102,9 +197,15 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
             break;
 
         case 0x2000: // CALL nnn - Call subroutine at nnn
-            cpu->stack[cpu->sp] = cpu->pc;
-            cpu->sp++;
-            cpu->pc = nnn;
+            {
+                // a call on a full stack faults and pushes into the spare slot,
+                // so the valid frames below it are left intact
+                bool overflow = cpu->sp >= STACK_DEPTH;
+                flag_fault(cpu, pc, overflow, FAULT_STACK_OVERFLOW);
+                cpu->stack[overflow ? STACK_DEPTH : cpu->sp] = cpu->pc;
+                cpu->sp += !overflow;
+                cpu->pc = nnn;
+            }
             break;
 
         case 0x3000: // SE Vx, kk - Skip next instruction if Vx == kk
@@ -140,12 +241,21 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
                     break;
                 case 0x1: // OR Vx, Vy - Set Vx = Vx OR Vy
                     cpu->V[x] |= cpu->V[y];
+                    if (cpu->config.quirks & QUIRK_VF_RESET) {
+                        cpu->V[0xF] = 0;
+                    }
                     break;
                 case 0x2: // AND Vx, Vy - Set Vx = Vx AND Vy
                     cpu->V[x] &= cpu->V[y];
+                    if (cpu->config.quirks & QUIRK_VF_RESET) {
+                        cpu->V[0xF] = 0;
+                    }
                     break;
                 case 0x3: // XOR Vx, Vy - Set Vx = Vx XOR Vy
                     cpu->V[x] ^= cpu->V[y];
+                    if (cpu->config.quirks & QUIRK_VF_RESET) {
+                        cpu->V[0xF] = 0;
+                    }
                     break;
                 case 0x4: // ADD Vx, Vy - Set Vx = Vx + Vy, set VF = carry
                     {
@@ -161,9 +271,12 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
                     cpu->V[0xF] = not_borrow_5;
                     break;
                 case 0x6: // SHR Vx - Set Vx = Vx SHR 1
-                    uint8_t lsb = cpu->V[y] & 0x1;
-                    cpu->V[x] = cpu->V[y] >> 1;
-                    cpu->V[0xF] = lsb;
+                    {
+                        uint8_t source = (cpu->config.quirks & QUIRK_SHIFT_VX) ? cpu->V[x] : cpu->V[y];
+                        uint8_t lsb = source & 0x1;
+                        cpu->V[x] = source >> 1;
+                        cpu->V[0xF] = lsb;
+                    }
                     break;
                 case 0x7: // SUBN Vx, Vy - Set Vx = Vy - Vx, set VF = NOT borrow
                     uint8_t not_borrow_7 = (cpu->V[y] >= cpu->V[x]) ? 1 : 0;
@@ -171,9 +284,12 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
                     cpu->V[0xF] = not_borrow_7;
                     break;
                 case 0xE: // SHL Vx - Set Vx = Vx SHL 1
-                    uint8_t msb = (cpu->V[y] & 0x80) >> 7;
-                    cpu->V[x] = cpu->V[y] << 1;
-                    cpu->V[0xF] = msb;
+                    {
+                        uint8_t source = (cpu->config.quirks & QUIRK_SHIFT_VX) ? cpu->V[x] : cpu->V[y];
+                        uint8_t msb = (source & 0x80) >> 7;
+                        cpu->V[x] = source << 1;
+                        cpu->V[0xF] = msb;
+                    }
                     break;
             }
             break;
@@ -188,8 +304,8 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
             cpu->I = nnn;
             break;
 
-        case 0xB000: // JP V0, nnn - Jump to location nnn + V0
-            cpu->pc = nnn + cpu->V[0];
+        case 0xB000: // JP V0, nnn - Jump to location nnn + V0 (or xnn + Vx)
+            cpu->pc = nnn + cpu->V[(cpu->config.quirks & QUIRK_JUMP_VX) ? x : 0];
             break;
 
         case 0xC000: // RND Vx, kk - Set Vx = random byte AND kk
@@ -198,15 +314,32 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
 
         case 0xD000: // DRW Vx, Vy, n - Draw n-byte sprite at (Vx, Vy)
             {
-                uint8_t x_pos = cpu->V[x] % VIDEO_WIDTH;
-                uint8_t y_pos = cpu->V[y] % VIDEO_HEIGHT;
+                uint8_t x_pos = cpu->V[x] & VIDEO_X_MASK;
+                uint8_t y_pos = cpu->V[y] & VIDEO_Y_MASK;
                 cpu->V[0xF] = 0;
 
-                for (int row = 0; row < n; row++) {
-                    uint8_t sprite_byte = cpu->memory[cpu->I + row];
-                    for (int col = 0; col < 8; col++) {
+                // clipping just shortens the loops; the pixel index itself
+                // always wraps, so it can never leave the framebuffer
+                int rows = n;
+                int cols = 8;
+                if (!(cpu->config.quirks & QUIRK_WRAP)) {
+                    if (rows > VIDEO_HEIGHT - y_pos) {
+                        rows = VIDEO_HEIGHT - y_pos;
+                    }
+                    if (cols > VIDEO_WIDTH - x_pos) {
+                        cols = VIDEO_WIDTH - x_pos;
+                    }
+                }
+
+                flag_fault(cpu, pc, cpu->I + rows > MEMORY_SIZE, FAULT_MEMORY);
+
+                for (int row = 0; row < rows; row++) {
+                    uint8_t sprite_byte = cpu->memory[(cpu->I + row) & MEMORY_MASK];
+                    uint32_t* screen_row = &cpu->video[((y_pos + row) & VIDEO_Y_MASK) * VIDEO_WIDTH];
+
+                    for (int col = 0; col < cols; col++) {
                         uint8_t sprite_pixel = sprite_byte & (0x80 >> col);
-                        uint32_t* screen_pixel = &cpu->video[(y_pos + row) * VIDEO_WIDTH + (x_pos + col)];
+                        uint32_t* screen_pixel = &screen_row[(x_pos + col) & VIDEO_X_MASK];
 
                         if (sprite_pixel) {
                             if (*screen_pixel == 0xFFFFFFFF) {
@@ -223,12 +356,14 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
         case 0xE000:
             switch (kk) {
                 case 0x9E: // SKP Vx - Skip next instruction if key Vx is pressed
-                    if (cpu->keypad[cpu->V[x]]) {
+                    flag_fault(cpu, pc, cpu->V[x] > KEY_MASK, FAULT_KEY);
+                    if (cpu->keypad[cpu->V[x] & KEY_MASK]) {
                         cpu->pc += 2;
                     }
                     break;
                 case 0xA1: // SKNP Vx - Skip next instruction if key Vx is not pressed
-                    if (!cpu->keypad[cpu->V[x]]) {
+                    flag_fault(cpu, pc, cpu->V[x] > KEY_MASK, FAULT_KEY);
+                    if (!cpu->keypad[cpu->V[x] & KEY_MASK]) {
                         cpu->pc += 2;
                     }
                     break;
@@ -268,18 +403,27 @@ void chip8_execute_cycle(ChipIn_t* cpu) {
                     cpu->I = 0x50 + (cpu->V[x] * 5);
                     break;
                 case 0x33: // LD B, Vx - Store BCD representation of Vx
-                    cpu->memory[cpu->I] = cpu->V[x] / 100;
-                    cpu->memory[cpu->I + 1] = (cpu->V[x] / 10) % 10;
-                    cpu->memory[cpu->I + 2] = cpu->V[x] % 10;
+                    flag_fault(cpu, pc, cpu->I > MEMORY_SIZE - 3, FAULT_MEMORY);
+                    cpu->memory[cpu->I & MEMORY_MASK] = cpu->V[x] / 100;
+                    cpu->memory[(cpu->I + 1) & MEMORY_MASK] = (cpu->V[x] / 10) % 10;
+                    cpu->memory[(cpu->I + 2) & MEMORY_MASK] = cpu->V[x] % 10;
                     break;
                 case 0x55: // LD [I], Vx - Store V0 through Vx in memory starting at I
+                    flag_fault(cpu, pc, cpu->I + x > MEMORY_MASK, FAULT_MEMORY);
                     for (int i = 0; i <= x; i++) {
-                        cpu->memory[cpu->I + i] = cpu->V[i];
+                        cpu->memory[(cpu->I + i) & MEMORY_MASK] = cpu->V[i];
+                    }
+                    if (cpu->config.quirks & QUIRK_MEMORY_INC) {
+                        cpu->I += x + 1;
                     }
                     break;
                 case 0x65: // LD Vx, [I] - Read V0 through Vx from memory starting at I
+                    flag_fault(cpu, pc, cpu->I + x > MEMORY_MASK, FAULT_MEMORY);
                     for (int i = 0; i <= x; i++) {
-                        cpu->V[i] = cpu->memory[cpu->I + i];
+                        cpu->V[i] = cpu->memory[(cpu->I + i) & MEMORY_MASK];
+                    }
+                    if (cpu->config.quirks & QUIRK_MEMORY_INC) {
+                        cpu->I += x + 1;
                     }
                     break;
             }
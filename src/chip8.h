@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 // constants
 #define MEMORY_SIZE 4096
@@ -13,6 +15,39 @@
 #define NUM_KEYS 16
 #define FONTSET_SIZE 80
 #define ROM_START_ADDRESS 0x200
+#define DEFAULT_CYCLES_PER_FRAME 10
+
+// every size above that gets indexed by ROM-controlled values is a power of
+// two, so the core wraps indices with these masks instead of range checks
+#define MEMORY_MASK (MEMORY_SIZE - 1)
+#define STACK_MASK (STACK_DEPTH - 1)
+#define KEY_MASK (NUM_KEYS - 1)
+#define VIDEO_X_MASK (VIDEO_WIDTH - 1)
+#define VIDEO_Y_MASK (VIDEO_HEIGHT - 1)
+
+// fault flags (ChipIn_t.faults): set when a ROM does something out of range.
+// the access is wrapped and execution continues; the host decides what to do.
+#define FAULT_STACK_OVERFLOW  0x01  // 2nnn with a full stack
+#define FAULT_STACK_UNDERFLOW 0x02  // 00EE with an empty stack
+#define FAULT_MEMORY          0x04  // fetch, sprite or Fx33/Fx55/Fx65 past 4KB
+#define FAULT_KEY             0x08  // Ex9E/ExA1 with Vx > 0xF
+#define FAULT_COUNT 4
+
+// quirk flags (interpreter behaviours that differ between CHIP-8 variants)
+#define QUIRK_SHIFT_VX    0x01  // 8xy6/8xyE shift Vx in place instead of Vy
+#define QUIRK_MEMORY_INC  0x02  // Fx55/Fx65 leave I pointing past the last register
+#define QUIRK_JUMP_VX     0x04  // Bxnn jumps to xnn + Vx instead of nnn + V0
+#define QUIRK_VF_RESET    0x08  // 8xy1/8xy2/8xy3 clear VF
+#define QUIRK_WRAP        0x10  // sprites wrap around the screen edges instead of clipping
+
+// per-ROM settings (defaults from chip8_init, overridden by the ROM database)
+typedef struct {
+    uint16_t cycles_per_frame;  // instructions per 60Hz frame
+    uint8_t quirks;             // QUIRK_* flags
+    uint8_t scale;              // display scale, 0 = frontend default
+    uint32_t palette[2];        // RGBA8888 background, foreground
+    uint8_t keymap[NUM_KEYS];   // host key i drives CHIP-8 key keymap[i]
+} ChipInConfig_t;
 
 // main struct (encapsulates VM)
 typedef struct {
@@ -21,8 +56,8 @@ typedef struct {
     uint16_t I;
     uint16_t pc;
 
-    uint16_t stack[STACK_DEPTH];
-    uint8_t sp;
+    uint16_t stack[STACK_DEPTH + 1]; // the extra slot absorbs overflowing calls
+    uint8_t sp;                 // 0..STACK_DEPTH, even after stack faults
 
     uint8_t delay_timer;
     uint8_t sound_timer;
@@ -31,18 +66,29 @@ typedef struct {
     uint32_t video[VIDEO_WIDTH * VIDEO_HEIGHT];
 
     bool draw_flag;
+    uint8_t faults;             // sticky FAULT_* flags, cleared by the host
+    uint16_t fault_pc[FAULT_COUNT]; // per flag: address of the last instruction that raised it
+
+    ChipInConfig_t config;
+    uint64_t rom_hash;
 } ChipIn_t;
 
 // public API
 void chip8_init(ChipIn_t* cpu);
 bool chip8_load_rom(ChipIn_t* cpu, const char* filename);
+void chip8_configure_rom(ChipIn_t* cpu, const uint8_t* rom, size_t size);
+void chip8_set_keypad(ChipIn_t* cpu, const uint8_t* host_keys);
 void chip8_execute_cycle(ChipIn_t* cpu);
+const char* chip8_fault_name(uint8_t fault);
+uint16_t chip8_fault_pc(const ChipIn_t* cpu, uint8_t fault);
+void chip8_report_faults(ChipIn_t* cpu, FILE* out, const char* prefix);
 
 // HAL interface functions
 void hal_draw_screen(uint32_t* video_buffer);
 void hal_get_keypad_state(uint8_t* keypad);
 bool hal_should_quit(void);
 void hal_init(void);
+void hal_configure(const ChipInConfig_t* config);
 void hal_cleanup(void);
 
 #endif //CHIPIN_CHIP8_H
\ No newline at end of file
@@ -0,0 +1,710 @@
+#include "export.h"
+#include <stdlib.h>
+#include <string.h>
+
+// longest run of identical frames folded into a single image
+// (keeps GIF centisecond and APNG uint16 delays in range)
+#define EXPORT_MAX_RUN 30000
+
+// GIF LZW dictionary limit
+#define GIF_MAX_CODES 4096
+
+// viewers replace delays of 0-1cs with ~10cs, so never write less than this
+#define GIF_MIN_DELAY 2
+
+// GIF encoder workspace
+typedef struct {
+    uint16_t tree[GIF_MAX_CODES][2];  // LZW children for pixel values 0/1
+    uint8_t block[255];
+    int block_len;
+    uint32_t bits;
+    int nbits;
+} GifScratch_t;
+
+// ---------------------------------------------------------------------------
+// helpers
+
+static inline bool pixel_on(const uint32_t* video, int out_x, int out_y, int scale) {
+    return video[(out_y / scale) * VIDEO_WIDTH + (out_x / scale)] != 0;
+}
+
+static void put_le16(FILE* file, uint16_t value) {
+    fputc(value & 0xFF, file);
+    fputc(value >> 8, file);
+}
+
+static void store_be32(uint8_t* out, uint32_t value) {
+    out[0] = value >> 24;
+    out[1] = (value >> 16) & 0xFF;
+    out[2] = (value >> 8) & 0xFF;
+    out[3] = value & 0xFF;
+}
+
+static void store_be16(uint8_t* out, uint16_t value) {
+    out[0] = value >> 8;
+    out[1] = value & 0xFF;
+}
+
+// ---------------------------------------------------------------------------
+// Y4M (raw 4:2:0, every written frame is a full picture)
+
+// studio-range BT.601 conversion of the two palette entries
+static void y4m_convert_palette(Exporter_t* ex) {
+    for (int i = 0; i < 2; i++) {
+        int r = ex->palette_rgb[i * 3];
+        int g = ex->palette_rgb[i * 3 + 1];
+        int b = ex->palette_rgb[i * 3 + 2];
+        ex->palette_yuv[i][0] = 16 + ((66 * r + 129 * g + 25 * b + 128) >> 8);
+        ex->palette_yuv[i][1] = 128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8);
+        ex->palette_yuv[i][2] = 128 + ((112 * r - 94 * g - 18 * b + 128) >> 8);
+    }
+}
+
+static bool y4m_write_header(Exporter_t* ex) {
+    fprintf(ex->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+            ex->width, ex->height, EXPORT_FPS);
+    return !ferror(ex->file);
+}
+
+static bool y4m_write_image(Exporter_t* ex, const uint32_t* video) {
+    uint8_t* row = ex->scratch;
+
+    fputs("FRAME\n", ex->file);
+    for (int y = 0; y < ex->height; y++) {
+        for (int x = 0; x < ex->width; x++) {
+            row[x] = ex->palette_yuv[pixel_on(video, x, y, ex->scale)][0];
+        }
+        fwrite(row, 1, ex->width, ex->file);
+    }
+
+    // chroma planes take the top-left pixel of each 2x2 block
+    for (int plane = 1; plane <= 2; plane++) {
+        for (int y = 0; y < ex->height / 2; y++) {
+            for (int x = 0; x < ex->width / 2; x++) {
+                row[x] = ex->palette_yuv[pixel_on(video, x * 2, y * 2, ex->scale)][plane];
+            }
+            fwrite(row, 1, ex->width / 2, ex->file);
+        }
+    }
+
+    return !ferror(ex->file);
+}
+
+// ---------------------------------------------------------------------------
+// GIF (2-colour global palette, one LZW-coded image per distinct frame)
+
+static bool gif_write_header(Exporter_t* ex) {
+    fputs("GIF89a", ex->file);
+    put_le16(ex->file, ex->width);
+    put_le16(ex->file, ex->height);
+    fputc(0x80, ex->file);  // global colour table, 2 entries
+    fputc(0, ex->file);     // background colour index
+    fputc(0, ex->file);     // pixel aspect ratio
+    fwrite(ex->palette_rgb, 1, sizeof(ex->palette_rgb), ex->file);
+
+    // NETSCAPE2.0 extension: loop forever
+    static const uint8_t loop[] = {
+        0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+        0x03, 0x01, 0x00, 0x00, 0x00
+    };
+    fwrite(loop, 1, sizeof(loop), ex->file);
+
+    return !ferror(ex->file);
+}
+
+static void gif_put_code(Exporter_t* ex, uint32_t code, int size) {
+    GifScratch_t* gif = (GifScratch_t*)ex->scratch;
+
+    gif->bits |= code << gif->nbits;
+    gif->nbits += size;
+
+    while (gif->nbits >= 8) {
+        gif->block[gif->block_len++] = gif->bits & 0xFF;
+        gif->bits >>= 8;
+        gif->nbits -= 8;
+
+        if (gif->block_len == 255) {
+            fputc(255, ex->file);
+            fwrite(gif->block, 1, 255, ex->file);
+            gif->block_len = 0;
+        }
+    }
+}
+
+static bool gif_write_image(Exporter_t* ex, const uint32_t* video, uint32_t delay_cs) {
+    GifScratch_t* gif = (GifScratch_t*)ex->scratch;
+    const int min_code_size = 2;
+    const uint32_t clear_code = 1u << min_code_size;
+    const uint32_t end_code = clear_code + 1;
+
+    // graphic control extension (frame duration)
+    fputc(0x21, ex->file);
+    fputc(0xF9, ex->file);
+    fputc(0x04, ex->file);
+    fputc(0x00, ex->file);
+    put_le16(ex->file, delay_cs);
+    fputc(0x00, ex->file);
+    fputc(0x00, ex->file);
+
+    // image descriptor covering the whole canvas
+    fputc(0x2C, ex->file);
+    put_le16(ex->file, 0);
+    put_le16(ex->file, 0);
+    put_le16(ex->file, ex->width);
+    put_le16(ex->file, ex->height);
+    fputc(0x00, ex->file);
+
+    fputc(min_code_size, ex->file);
+
+    memset(gif->tree, 0, sizeof(gif->tree));
+    gif->block_len = 0;
+    gif->bits = 0;
+    gif->nbits = 0;
+
+    int code_size = min_code_size + 1;
+    uint32_t max_code = end_code;
+    int32_t current = -1;
+
+    gif_put_code(ex, clear_code, code_size);
+
+    for (int y = 0; y < ex->height; y++) {
+        for (int x = 0; x < ex->width; x++) {
+            uint8_t value = pixel_on(video, x, y, ex->scale) ? 1 : 0;
+
+            if (current < 0) {
+                current = value;
+            } else if (gif->tree[current][value]) {
+                current = gif->tree[current][value];
+            } else {
+                gif_put_code(ex, current, code_size);
+
+                gif->tree[current][value] = ++max_code;
+                if (max_code >= (1u << code_size)) {
+                    code_size++;
+                }
+
+                // dictionary full: start over
+                if (max_code == GIF_MAX_CODES - 1) {
+                    gif_put_code(ex, clear_code, code_size);
+                    memset(gif->tree, 0, sizeof(gif->tree));
+                    code_size = min_code_size + 1;
+                    max_code = end_code;
+                }
+
+                current = value;
+            }
+        }
+    }
+
+    gif_put_code(ex, current, code_size);
+    gif_put_code(ex, end_code, code_size);
+    gif_put_code(ex, 0, 7);  // flush the last partial byte
+
+    if (gif->block_len > 0) {
+        fputc(gif->block_len, ex->file);
+        fwrite(gif->block, 1, gif->block_len, ex->file);
+    }
+    fputc(0x00, ex->file);  // block terminator
+
+    return !ferror(ex->file);
+}
+
+// ---------------------------------------------------------------------------
+// APNG (1-bit palette PNG, one fixed-Huffman deflate stream per distinct frame)
+
+static uint32_t crc_table[256];
+static bool crc_table_ready = false;
+
+static void crc_init(void) {
+    if (crc_table_ready) {
+        return;
+    }
+
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[n] = c;
+    }
+    crc_table_ready = true;
+}
+
+static uint32_t crc_update(uint32_t crc, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// write a PNG chunk whose data is `prefix` (may be empty) followed by `data`
+static void png_write_chunk(FILE* file, const char* type,
+                            const uint8_t* prefix, size_t prefix_len,
+                            const uint8_t* data, size_t len) {
+    uint8_t header[8];
+    store_be32(header, (uint32_t)(prefix_len + len));
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, file);
+
+    uint32_t crc = crc_update(0xFFFFFFFFu, header + 4, 4);
+    if (prefix_len > 0) {
+        crc = crc_update(crc, prefix, prefix_len);
+        fwrite(prefix, 1, prefix_len, file);
+    }
+    if (len > 0) {
+        crc = crc_update(crc, data, len);
+        fwrite(data, 1, len, file);
+    }
+
+    uint8_t trailer[4];
+    store_be32(trailer, crc ^ 0xFFFFFFFFu);
+    fwrite(trailer, 1, 4, file);
+}
+
+static void png_write_actl(Exporter_t* ex, uint32_t num_frames) {
+    uint8_t actl[8];
+    store_be32(actl, num_frames);
+    store_be32(actl + 4, 0);  // loop forever
+    png_write_chunk(ex->file, "acTL", NULL, 0, actl, sizeof(actl));
+}
+
+// bytes per scanline including the leading filter-type byte
+static inline size_t png_row_len(const Exporter_t* ex) {
+    return 1 + (size_t)(ex->width + 7) / 8;
+}
+
+static size_t png_deflate_capacity(const Exporter_t* ex) {
+    // worst case is all 9-bit literals plus the zlib framing
+    size_t raw = png_row_len(ex) * ex->height;
+    return raw + raw / 8 + 64;
+}
+
+static bool png_write_header(Exporter_t* ex) {
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, sizeof(signature), ex->file);
+
+    uint8_t ihdr[13];
+    store_be32(ihdr, ex->width);
+    store_be32(ihdr + 4, ex->height);
+    ihdr[8] = 1;    // bit depth
+    ihdr[9] = 3;    // colour type: palette
+    ihdr[10] = 0;   // deflate
+    ihdr[11] = 0;   // adaptive filtering
+    ihdr[12] = 0;   // no interlace
+    png_write_chunk(ex->file, "IHDR", NULL, 0, ihdr, sizeof(ihdr));
+
+    // frame count is unknown until the run ends, so acTL gets patched on close
+    ex->actl_offset = ftell(ex->file);
+    if (ex->actl_offset < 0) {
+        fprintf(stderr, "APNG export needs a seekable output file.\n");
+        return false;
+    }
+    png_write_actl(ex, 0);
+
+    png_write_chunk(ex->file, "PLTE", NULL, 0, ex->palette_rgb, sizeof(ex->palette_rgb));
+
+    return !ferror(ex->file);
+}
+
+typedef struct {
+    uint8_t* out;
+    size_t len;
+    uint32_t bits;
+    int nbits;
+} BitWriter_t;
+
+static void bits_put(BitWriter_t* bw, uint32_t value, int count) {
+    bw->bits |= value << bw->nbits;
+    bw->nbits += count;
+    while (bw->nbits >= 8) {
+        bw->out[bw->len++] = bw->bits & 0xFF;
+        bw->bits >>= 8;
+        bw->nbits -= 8;
+    }
+}
+
+// Huffman codes are stored MSB-first in an LSB-first stream
+static void bits_put_huffman(BitWriter_t* bw, uint32_t code, int count) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    bits_put(bw, reversed, count);
+}
+
+// fixed Huffman literal/length alphabet (RFC 1951, 3.2.6)
+static void deflate_symbol(BitWriter_t* bw, int symbol) {
+    if (symbol < 144) {
+        bits_put_huffman(bw, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits_put_huffman(bw, 0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+        bits_put_huffman(bw, symbol - 256, 7);
+    } else {
+        bits_put_huffman(bw, 0xC0 + (symbol - 280), 8);
+    }
+}
+
+static void deflate_copy(BitWriter_t* bw, int length, int distance) {
+    static const uint16_t length_base[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const uint8_t length_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const uint16_t distance_base[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    static const uint8_t distance_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    int lc = 28;
+    while (length_base[lc] > length) {
+        lc--;
+    }
+    deflate_symbol(bw, 257 + lc);
+    bits_put(bw, length - length_base[lc], length_extra[lc]);
+
+    int dc = 29;
+    while (distance_base[dc] > distance) {
+        dc--;
+    }
+    bits_put_huffman(bw, dc, 5);
+    bits_put(bw, distance - distance_base[dc], distance_extra[dc]);
+}
+
+// emit `length` (>= 3) bytes as back-references, each between 3 and 258 long
+static void deflate_copy_run(BitWriter_t* bw, int length, int distance) {
+    while (length > 0) {
+        int chunk = length;
+        if (chunk > 258) {
+            chunk = (length - 258 < 3) ? length - 3 : 258;
+        }
+        deflate_copy(bw, chunk, distance);
+        length -= chunk;
+    }
+}
+
+// compress one frame into a zlib stream. scanlines that repeat the previous
+// one (every scaled-up row, plus identical CHIP-8 rows) become a single
+// back-reference; the rest are run-length coded.
+static size_t png_deflate_frame(Exporter_t* ex, const uint32_t* video, uint8_t* out) {
+    const size_t row_len = png_row_len(ex);
+    uint8_t* row = ex->scratch;
+    uint8_t* prev = row + row_len;
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+
+    BitWriter_t bw = { out, 0, 0, 0 };
+    bw.out[bw.len++] = 0x78;  // zlib: deflate, 32K window
+    bw.out[bw.len++] = 0x01;
+    bits_put(&bw, 1, 1);      // BFINAL
+    bits_put(&bw, 1, 2);      // BTYPE = fixed Huffman
+
+    for (int y = 0; y < ex->height; y++) {
+        memset(row, 0, row_len);  // filter type 0 + cleared pixels
+        for (int x = 0; x < ex->width; x++) {
+            if (pixel_on(video, x, y, ex->scale)) {
+                row[1 + x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+
+        if (y > 0 && memcmp(row, prev, row_len) == 0) {
+            deflate_copy_run(&bw, (int)row_len, (int)row_len);
+        } else {
+            size_t i = 0;
+            while (i < row_len) {
+                size_t j = i + 1;
+                while (j < row_len && row[j] == row[i]) {
+                    j++;
+                }
+
+                deflate_symbol(&bw, row[i]);
+                int run = (int)(j - i - 1);
+                if (run >= 3) {
+                    deflate_copy_run(&bw, run, 1);
+                } else {
+                    for (int k = 0; k < run; k++) {
+                        deflate_symbol(&bw, row[i]);
+                    }
+                }
+                i = j;
+            }
+        }
+
+        for (size_t i = 0; i < row_len; i++) {
+            adler_a = (adler_a + row[i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+
+        uint8_t* swap = prev;
+        prev = row;
+        row = swap;
+    }
+
+    deflate_symbol(&bw, 256);  // end of block
+    if (bw.nbits > 0) {
+        bits_put(&bw, 0, 8 - bw.nbits);
+    }
+
+    store_be32(bw.out + bw.len, (adler_b << 16) | adler_a);
+    return bw.len + 4;
+}
+
+static bool png_write_image(Exporter_t* ex, const uint32_t* video, uint32_t frames) {
+    uint8_t fctl[26];
+    store_be32(fctl, ex->apng_sequence++);
+    store_be32(fctl + 4, ex->width);
+    store_be32(fctl + 8, ex->height);
+    store_be32(fctl + 12, 0);       // x offset
+    store_be32(fctl + 16, 0);       // y offset
+    store_be16(fctl + 20, frames);  // delay numerator
+    store_be16(fctl + 22, EXPORT_FPS);
+    fctl[24] = 0;                   // dispose: none
+    fctl[25] = 0;                   // blend: source
+    png_write_chunk(ex->file, "fcTL", NULL, 0, fctl, sizeof(fctl));
+
+    uint8_t* compressed = ex->scratch + 2 * png_row_len(ex);
+    size_t len = png_deflate_frame(ex, video, compressed);
+
+    if (ex->frames_out == 0) {
+        png_write_chunk(ex->file, "IDAT", NULL, 0, compressed, len);
+    } else {
+        uint8_t sequence[4];
+        store_be32(sequence, ex->apng_sequence++);
+        png_write_chunk(ex->file, "fdAT", sequence, sizeof(sequence), compressed, len);
+    }
+
+    return !ferror(ex->file);
+}
+
+static bool png_finish(Exporter_t* ex) {
+    png_write_chunk(ex->file, "IEND", NULL, 0, NULL, 0);
+
+    long end = ftell(ex->file);
+    if (end < 0 || fseek(ex->file, ex->actl_offset, SEEK_SET) != 0) {
+        fprintf(stderr, "Failed to patch APNG frame count.\n");
+        return false;
+    }
+    png_write_actl(ex, ex->frames_out);
+    fseek(ex->file, end, SEEK_SET);
+
+    return !ferror(ex->file);
+}
+
+// ---------------------------------------------------------------------------
+// public API
+
+// write the pending image, splitting very long runs so delays stay in range.
+// `final` is set for the last image of the file, which is always written.
+static bool export_flush(Exporter_t* ex, bool final) {
+    if (!ex->has_pending) {
+        return true;
+    }
+
+    uint32_t remaining = ex->pending_frames;
+    while (remaining > 0) {
+        uint32_t frames = remaining > EXPORT_MAX_RUN ? EXPORT_MAX_RUN : remaining;
+        bool ok = true;
+        bool written = true;
+
+        ex->frames_flushed += frames;
+
+        switch (ex->format) {
+            case EXPORT_Y4M:
+                // never folded (export_open refuses changed_only), so one picture
+                ok = y4m_write_image(ex, ex->pending);
+                break;
+            case EXPORT_GIF:
+                {
+                    // round against the running total so 1/60s frames don't drift.
+                    // an image that would last under GIF_MIN_DELAY is dropped and
+                    // its time goes to the next one, so 60fps input plays back at
+                    // roughly 40-50fps of images with correct overall timing.
+                    uint32_t target = (uint32_t)(((uint64_t)ex->frames_flushed * 100 + EXPORT_FPS / 2) / EXPORT_FPS);
+                    uint32_t delay = target - ex->time_out;
+                    if (delay < GIF_MIN_DELAY && !(final && frames == remaining)) {
+                        written = false;
+                        break;
+                    }
+                    if (delay < GIF_MIN_DELAY) {
+                        delay = GIF_MIN_DELAY;
+                        target = ex->time_out + delay;
+                    }
+                    ok = gif_write_image(ex, ex->pending, delay);
+                    ex->time_out = target;
+                }
+                break;
+            case EXPORT_APNG:
+                ok = png_write_image(ex, ex->pending, frames);
+                break;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Failed to write video frame.\n");
+            return false;
+        }
+
+        if (written) {
+            ex->frames_out++;
+        }
+        remaining -= frames;
+    }
+
+    ex->has_pending = false;
+    return true;
+}
+
+bool export_open(Exporter_t* ex, const char* filename, ExportFormat_t format,
+                 int scale, const uint32_t palette[2], bool changed_only) {
+    memset(ex, 0, sizeof(Exporter_t));
+
+    if (scale < 1 || scale > EXPORT_MAX_SCALE) {
+        fprintf(stderr, "Export scale must be between 1 and %d.\n", EXPORT_MAX_SCALE);
+        return false;
+    }
+
+    // Y4M has a fixed frame rate, so folded repeats would play back too fast
+    if (changed_only && format == EXPORT_Y4M) {
+        fprintf(stderr, "--changed-only is not supported for Y4M output.\n");
+        return false;
+    }
+
+    ex->format = format;
+    ex->scale = scale;
+    ex->width = VIDEO_WIDTH * scale;
+    ex->height = VIDEO_HEIGHT * scale;
+    ex->changed_only = changed_only;
+
+    // RGBA8888 -> packed RGB
+    for (int i = 0; i < 2; i++) {
+        ex->palette_rgb[i * 3] = palette[i] >> 24;
+        ex->palette_rgb[i * 3 + 1] = (palette[i] >> 16) & 0xFF;
+        ex->palette_rgb[i * 3 + 2] = (palette[i] >> 8) & 0xFF;
+    }
+
+    size_t scratch_size = 0;
+    switch (format) {
+        case EXPORT_Y4M:
+            scratch_size = ex->width;
+            y4m_convert_palette(ex);
+            break;
+        case EXPORT_GIF:
+            scratch_size = sizeof(GifScratch_t);
+            break;
+        case EXPORT_APNG:
+            scratch_size = 2 * png_row_len(ex) + png_deflate_capacity(ex);
+            crc_init();
+            break;
+    }
+
+    ex->scratch = malloc(scratch_size);
+    if (!ex->scratch) {
+        fprintf(stderr, "Out of memory for video encoder.\n");
+        return false;
+    }
+
+    ex->file = fopen(filename, "wb");
+    if (!ex->file) {
+        perror("Failed to open video output");
+        free(ex->scratch);
+        ex->scratch = NULL;
+        return false;
+    }
+
+    bool ok = false;
+    switch (format) {
+        case EXPORT_Y4M:
+            ok = y4m_write_header(ex);
+            break;
+        case EXPORT_GIF:
+            ok = gif_write_header(ex);
+            break;
+        case EXPORT_APNG:
+            ok = png_write_header(ex);
+            break;
+    }
+
+    if (!ok) {
+        fclose(ex->file);
+        free(ex->scratch);
+        ex->file = NULL;
+        ex->scratch = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool export_frame(Exporter_t* ex, const uint32_t* video) {
+    ex->frames_in++;
+
+    if (ex->has_pending && ex->changed_only &&
+        ex->pending_frames < UINT32_MAX &&
+        memcmp(ex->pending, video, sizeof(ex->pending)) == 0) {
+        ex->pending_frames++;
+        return true;
+    }
+
+    if (!export_flush(ex, false)) {
+        return false;
+    }
+
+    memcpy(ex->pending, video, sizeof(ex->pending));
+    ex->pending_frames = 1;
+    ex->has_pending = true;
+    return true;
+}
+
+bool export_close(Exporter_t* ex) {
+    if (!ex->file) {
+        return false;
+    }
+
+    bool ok = export_flush(ex, true);
+
+    if (ok) {
+        switch (ex->format) {
+            case EXPORT_Y4M:
+                break;
+            case EXPORT_GIF:
+                fputc(0x3B, ex->file);  // trailer
+                break;
+            case EXPORT_APNG:
+                ok = png_finish(ex);
+                break;
+        }
+    }
+
+    if (fclose(ex->file) != 0) {
+        ok = false;
+    }
+    free(ex->scratch);
+    ex->file = NULL;
+    ex->scratch = NULL;
+
+    return ok;
+}
+
+bool export_format_from_filename(const char* filename, ExportFormat_t* format) {
+    const char* dot = strrchr(filename, '.');
+    if (!dot) {
+        return false;
+    }
+
+    if (strcmp(dot, ".y4m") == 0) {
+        *format = EXPORT_Y4M;
+    } else if (strcmp(dot, ".gif") == 0) {
+        *format = EXPORT_GIF;
+    } else if (strcmp(dot, ".png") == 0 || strcmp(dot, ".apng") == 0) {
+        *format = EXPORT_APNG;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef CHIPIN_EXPORT_H
+#define CHIPIN_EXPORT_H
+
+#include "chip8.h"
+#include <stdio.h>
+
+// emulated frames per second of video (matches the ~60 FPS desktop loop)
+#define EXPORT_FPS 60
+#define EXPORT_MAX_SCALE 32
+
+typedef enum {
+    EXPORT_Y4M,
+    EXPORT_GIF,
+    EXPORT_APNG
+} ExportFormat_t;
+
+// streaming video encoder. only the most recent frame is kept in memory:
+// it is written out once the next *different* frame arrives (or on close),
+// so repeated frames can be folded into that frame's duration.
+typedef struct {
+    FILE* file;
+    ExportFormat_t format;
+    int scale;
+    int width;
+    int height;
+    bool changed_only;
+    uint8_t palette_rgb[6];     // background, foreground
+    uint8_t palette_yuv[2][3];
+
+    uint32_t pending[VIDEO_WIDTH * VIDEO_HEIGHT];
+    uint32_t pending_frames;    // emulated frames covered by the pending image
+    bool has_pending;
+
+    uint32_t frames_in;         // emulated frames received
+    uint32_t frames_flushed;    // emulated frames already written out
+    uint32_t frames_out;        // images written to the file
+    uint32_t time_out;          // GIF: centiseconds written so far
+
+    long actl_offset;           // APNG: position of acTL, patched on close
+    uint32_t apng_sequence;
+
+    uint8_t* scratch;           // per-format encoder workspace
+} Exporter_t;
+
+// public API
+bool export_open(Exporter_t* ex, const char* filename, ExportFormat_t format,
+                 int scale, const uint32_t palette[2], bool changed_only);
+bool export_frame(Exporter_t* ex, const uint32_t* video);
+bool export_close(Exporter_t* ex);
+
+// guess the format from a file extension (.y4m, .gif, .png/.apng)
+bool export_format_from_filename(const char* filename, ExportFormat_t* format);
+
+#endif //CHIPIN_EXPORT_H
@@ -35,6 +35,11 @@ void hal_init(void) {
     printf("CHIP-8 Pico HAL initialized\n");
 }
 
+void hal_configure(const ChipInConfig_t* config) {
+    // nothing to apply until there is real display hardware
+    (void)config;
+}
+
 void hal_cleanup(void) {
     // Turn off buzzer
     gpio_put(BUZZER_PIN, 0);
@@ -7,6 +7,10 @@ static SDL_Renderer* renderer = NULL;
 static SDL_Texture* texture = NULL;
 static bool quit_requested = false;
 
+// RGBA8888 background/foreground, replaced by hal_configure
+static uint32_t palette[2] = { 0x000000FF, 0xFFFFFFFF };
+static uint32_t frame_pixels[VIDEO_WIDTH * VIDEO_HEIGHT];
+
 // CHIP-8 keypad mapping to SDL keys
 static const SDL_Scancode keymap[NUM_KEYS] = {
     SDL_SCANCODE_X,    // 0
@@ -65,6 +69,15 @@ void hal_init(void) {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 }
 
+void hal_configure(const ChipInConfig_t* config) {
+    palette[0] = config->palette[0];
+    palette[1] = config->palette[1];
+
+    if (window && config->scale) {
+        SDL_SetWindowSize(window, VIDEO_WIDTH * config->scale, VIDEO_HEIGHT * config->scale);
+    }
+}
+
 void hal_cleanup(void) {
     if (texture) {
         SDL_DestroyTexture(texture);
@@ -85,7 +98,12 @@ void hal_cleanup(void) {
 }
 
 void hal_draw_screen(uint32_t* video_buffer) {
-    SDL_UpdateTexture(texture, NULL, video_buffer, VIDEO_WIDTH * sizeof(uint32_t));
+    // the core only stores on/off; colour it with the ROM's palette
+    for (int i = 0; i < VIDEO_WIDTH * VIDEO_HEIGHT; i++) {
+        frame_pixels[i] = palette[video_buffer[i] != 0];
+    }
+
+    SDL_UpdateTexture(texture, NULL, frame_pixels, VIDEO_WIDTH * sizeof(uint32_t));
     SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, texture, NULL, NULL);
     SDL_RenderPresent(renderer);
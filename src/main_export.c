@@ -0,0 +1,143 @@
+#include "chip8.h"
+#include "export.h"
+#include "romdb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// headless video export: runs the core flat out (no SDL, no frame pacing)
+// and streams every emulated frame to a Y4M, GIF or APNG file
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Usage: %s <ROM file> <output.y4m|.gif|.png> [options]\n", program);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --frames N        emulated frames to record (default 600)\n");
+    fprintf(stderr, "  --scale N         integer pixel scale, 1-%d (default: ROM database, else 4)\n", EXPORT_MAX_SCALE);
+    fprintf(stderr, "  --cycles N        instructions per frame (default: ROM database, else %d)\n", DEFAULT_CYCLES_PER_FRAME);
+    fprintf(stderr, "  --changed-only    fold repeated frames into the previous one (GIF/APNG only)\n");
+}
+
+// strict positive integer: rejects 0, negatives and trailing garbage
+static bool parse_count(const char* text, long* value) {
+    char* end;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < 1) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* rom_path = argv[1];
+    const char* out_path = argv[2];
+    long frames = 600;
+    long scale = 0;             // 0 = not given, take it from the ROM database
+    long cycles_per_frame = 0;
+    bool changed_only = false;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--changed-only") == 0) {
+            changed_only = true;
+        } else if (i + 1 < argc && (strcmp(argv[i], "--frames") == 0 ||
+                                    strcmp(argv[i], "--scale") == 0 ||
+                                    strcmp(argv[i], "--cycles") == 0)) {
+            const char* option = argv[i];
+            long value;
+            if (!parse_count(argv[++i], &value)) {
+                fprintf(stderr, "%s needs a positive integer, got '%s'\n", option, argv[i]);
+                return 1;
+            }
+
+            if (strcmp(option, "--frames") == 0) {
+                frames = value;
+            } else if (strcmp(option, "--scale") == 0) {
+                scale = value;
+            } else {
+                cycles_per_frame = value;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    ExportFormat_t format;
+    if (!export_format_from_filename(out_path, &format)) {
+        fprintf(stderr, "Unknown output format (use .y4m, .gif or .png): %s\n", out_path);
+        return 1;
+    }
+    if (changed_only && format == EXPORT_Y4M) {
+        fprintf(stderr, "--changed-only needs per-frame durations; use .gif or .png\n");
+        return 1;
+    }
+
+    // optional per-ROM settings
+    const char* db_path = getenv("CHIPIN_ROMDB");
+    romdb_load_file(db_path ? db_path : "chipin.db");
+
+    // initialize CHIP-8 system
+    ChipIn_t chip8;
+    chip8_init(&chip8);
+
+    // load ROM
+    if (!chip8_load_rom(&chip8, rom_path)) {
+        fprintf(stderr, "Failed to load ROM: %s\n", rom_path);
+        romdb_unload();
+        return 1;
+    }
+    romdb_unload();
+
+    // command-line options win over the database
+    if (cycles_per_frame == 0) {
+        cycles_per_frame = chip8.config.cycles_per_frame;
+    }
+    if (scale == 0) {
+        scale = chip8.config.scale ? chip8.config.scale : 4;
+        if (scale > EXPORT_MAX_SCALE) {
+            scale = EXPORT_MAX_SCALE;
+        }
+    }
+
+    Exporter_t exporter;
+    if (!export_open(&exporter, out_path, format, (int)scale, chip8.config.palette, changed_only)) {
+        fprintf(stderr, "Failed to open video output: %s\n", out_path);
+        return 1;
+    }
+
+    // no input device: the keypad stays released for the whole run
+    bool ok = true;
+    for (long frame = 0; frame < frames && ok; frame++) {
+        for (long i = 0; i < cycles_per_frame; i++) {
+            chip8_execute_cycle(&chip8);
+        }
+        chip8.draw_flag = false;
+
+        // faults are reported but never stop the capture
+        if (chip8.faults) {
+            char prefix[512];
+            snprintf(prefix, sizeof(prefix), "%s: frame %ld: ", rom_path, frame);
+            chip8_report_faults(&chip8, stderr, prefix);
+        }
+
+        ok = export_frame(&exporter, chip8.video);
+    }
+
+    if (!export_close(&exporter)) {
+        ok = false;
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Video export failed: %s\n", out_path);
+        return 1;
+    }
+
+    printf("Exported %u frames (%u images) to %s\n",
+           exporter.frames_in, exporter.frames_out, out_path);
+    return 0;
+}
@@ -1,21 +1,8 @@
 #include "chip8.h"
+#include "test_rom.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 
-// test ROM data
-static const uint8_t test_rom[] = {
-    0xA2, 0x2A, // LD I, 0x22A (point to sprite data)
-    0x60, 0x0C, // LD V0, 0x0C (X position)
-    0x61, 0x08, // LD V1, 0x08 (Y position)
-    0xD0, 0x1F, // DRW V0, V1, 15 (draw sprite)
-    0x12, 0x00, // JP 0x200 (infinite loop)
-
-    // sprite data (simple pattern)
-    0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
-    0x20, 0x60, 0x20, 0x20, 0x70, // 1
-    0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
-};
-
 // function to load ROM data into memory (since we don't have file system)
 bool load_test_rom(ChipIn_t* cpu) {
     if (sizeof(test_rom) > (MEMORY_SIZE - ROM_START_ADDRESS)) {
@@ -28,6 +15,9 @@ bool load_test_rom(ChipIn_t* cpu) {
         cpu->memory[ROM_START_ADDRESS + i] = test_rom[i];
     }
 
+    // pick up speed/quirks from the built-in ROM database
+    chip8_configure_rom(cpu, test_rom, sizeof(test_rom));
+
     printf("Test ROM loaded (%d bytes)\n", sizeof(test_rom));
     return true;
 }
@@ -50,21 +40,28 @@ int main() {
     printf("CHIP-8 system initialized\n");
     printf("Starting emulation loop...\n");
 
-    // main loop
+    // main loop: one batch of cycles per ~60Hz frame, sized by the ROM database
     uint32_t last_time = to_ms_since_boot(get_absolute_time());
-    const uint32_t CYCLES_PER_SECOND = 700;  // CHIP-8 typically runs at ~700Hz
-    const uint32_t MS_PER_CYCLE = 1000 / CYCLES_PER_SECOND;
+    const uint32_t MS_PER_FRAME = 16;
+    uint8_t host_keys[NUM_KEYS] = {0};
 
     while (!hal_should_quit()) {
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
 
-        // execute cycle at appropriate timing
-        if (current_time - last_time >= MS_PER_CYCLE) {
-            // update keypad state
-            hal_get_keypad_state(chip8.keypad);
+        if (current_time - last_time >= MS_PER_FRAME) {
+            for (int i = 0; i < chip8.config.cycles_per_frame; i++) {
+                // update keypad state (the HAL keeps the old state while debouncing)
+                hal_get_keypad_state(host_keys);
+                chip8_set_keypad(&chip8, host_keys);
 
-            // execute one cycle
-            chip8_execute_cycle(&chip8);
+                // execute one cycle
+                chip8_execute_cycle(&chip8);
+            }
+
+            // report ROM faults over serial (the core has already contained them)
+            if (chip8.faults) {
+                chip8_report_faults(&chip8, stdout, "");
+            }
 
             // handle sound
             extern void hal_make_sound(bool enable);
@@ -0,0 +1,103 @@
+#include "chip8.h"
+#include "romdb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// host-side helper for the ROM database:
+//   hash     print the database key of each ROM
+//   compile  turn a text database into the C table embedded in firmware
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Usage: %s hash <ROM file>...\n", program);
+    fprintf(stderr, "       %s compile <database.txt> [output.c]\n", program);
+}
+
+static int hash_roms(int count, char* paths[]) {
+    int status = 0;
+
+    for (int i = 0; i < count; i++) {
+        // load through the core so the hash matches what chip8_load_rom sees
+        ChipIn_t chip8;
+        chip8_init(&chip8);
+
+        if (!chip8_load_rom(&chip8, paths[i])) {
+            fprintf(stderr, "Failed to load ROM: %s\n", paths[i]);
+            status = 1;
+            continue;
+        }
+
+        printf("%016llx  %s\n", (unsigned long long)chip8.rom_hash, paths[i]);
+    }
+
+    return status;
+}
+
+static int compile_database(const char* db_path, const char* out_path) {
+    if (!romdb_load_file(db_path)) {
+        fprintf(stderr, "Failed to load ROM database: %s\n", db_path);
+        return 1;
+    }
+
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror("Failed to open output");
+        return 1;
+    }
+
+    size_t count;
+    const RomDbRecord_t* records = romdb_entries(&count);
+
+    // only the file name, so the output doesn't depend on where it was run from
+    const char* db_name = db_path;
+    for (const char* c = db_path; *c; c++) {
+        if (*c == '/' || *c == '\\') {
+            db_name = c + 1;
+        }
+    }
+
+    fprintf(out, "// generated from %s by `chipin_romdb compile` - do not edit\n", db_name);
+    fprintf(out, "#include \"romdb.h\"\n\n");
+    fprintf(out, "const RomDbRecord_t romdb_builtin[] = {\n");
+
+    for (size_t i = 0; i < count; i++) {
+        const RomDbRecord_t* r = &records[i];
+        fprintf(out, "    { 0x%016llxULL, %u, 0x%02X, %u, { ",
+                (unsigned long long)r->hash, r->cycles_per_frame, r->quirks, r->scale);
+        for (int j = 0; j < 6; j++) {
+            fprintf(out, "0x%02X%s", r->palette[j], j < 5 ? ", " : " }, { ");
+        }
+        for (int j = 0; j < NUM_KEYS / 2; j++) {
+            fprintf(out, "0x%02X%s", r->keymap[j], j < NUM_KEYS / 2 - 1 ? ", " : " } },\n");
+        }
+    }
+
+    // C has no empty arrays: keep a placeholder that the count excludes
+    if (count == 0) {
+        fprintf(out, "    { 0 },\n");
+    }
+
+    fprintf(out, "};\n\n");
+    fprintf(out, "const size_t romdb_builtin_count = %zu;\n", count);
+
+    bool ok = !ferror(out);
+    if (out != stdout && fclose(out) != 0) {
+        ok = false;
+    }
+
+    romdb_unload();
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "hash") == 0) {
+        return hash_roms(argc - 2, &argv[2]);
+    }
+
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "compile") == 0) {
+        return compile_database(argv[2], argc == 4 ? argv[3] : NULL);
+    }
+
+    print_usage(argv[0]);
+    return 1;
+}
@@ -1,16 +1,31 @@
 #include "chip8.h"
+#include "romdb.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <SDL2/SDL.h>
+#include <string.h>
+
+#ifdef CHIPIN_SHM
+#include "shm.h"
+#endif
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <ROM file>\n", argv[0]);
+    const char* shm_name = NULL;
+
+    if (argc == 4 && strcmp(argv[2], "--shm") == 0) {
+        shm_name = argv[3];
+    } else if (argc != 2) {
+        fprintf(stderr, "Usage: %s <ROM file> [--shm /name]\n", argv[0]);
         return 1;
     }
 
     // initialize HAL
     hal_init();
 
+    // optional per-ROM settings (falls back to the built-in table)
+    const char* db_path = getenv("CHIPIN_ROMDB");
+    romdb_load_file(db_path ? db_path : "chipin.db");
+
     // initialize CHIP-8 system
     ChipIn_t chip8;
     chip8_init(&chip8);
@@ -18,12 +33,39 @@ int main(int argc, char* argv[]) {
     // load ROM
     if (!chip8_load_rom(&chip8, argv[1])) {
         fprintf(stderr, "Failed to load ROM: %s\n", argv[1]);
+        romdb_unload();
         hal_cleanup();
         return 1;
     }
+    romdb_unload();
+
+    // apply palette/scale picked for this ROM
+    hal_configure(&chip8.config);
+
+    // optional shared-memory export for external observers
+#ifdef CHIPIN_SHM
+    ChipInShm_t* shm = NULL;
+    if (shm_name) {
+        shm = chipin_shm_create(shm_name);
+        if (!shm) {
+            fprintf(stderr, "Failed to create shared memory: %s\n", shm_name);
+            hal_cleanup();
+            return 1;
+        }
+        printf("Publishing VM state to shared memory: %s\n", shm_name);
+    }
+#else
+    if (shm_name) {
+        fprintf(stderr, "Shared memory export is not supported on this platform.\n");
+        hal_cleanup();
+        return 1;
+    }
+#endif
 
     printf("CHIP-8 Emulator Started\n");
     printf("ROM loaded: %s\n", argv[1]);
+    printf("ROM hash: %016llx (%u cycles per frame)\n",
+           (unsigned long long)chip8.rom_hash, chip8.config.cycles_per_frame);
     printf("Controls:\n");
     printf("  CHIP-8 Key -> Keyboard\n");
     printf("  1,2,3,C    -> 1,2,3,4\n");
@@ -33,22 +75,35 @@ int main(int argc, char* argv[]) {
     printf("  ESC        -> Quit\n\n");
     printf("  Have fun!! :) \n\n");
 
-    // main emulation loop
-    const int CYCLES_PER_FRAME = 10;  // adjust this to control emulation speed
+    // main emulation loop (speed comes from chip8.config.cycles_per_frame)
+    uint8_t host_keys[NUM_KEYS];
     uint32_t last_time = SDL_GetTicks();
 
     while (!hal_should_quit()) {
         uint32_t current_time = SDL_GetTicks();
 
         // run emulation cycles
-        for (int i = 0; i < CYCLES_PER_FRAME; i++) {
-            // update keypad state
-            hal_get_keypad_state(chip8.keypad);
+        for (int i = 0; i < chip8.config.cycles_per_frame; i++) {
+            // update keypad state (remapped per ROM)
+            hal_get_keypad_state(host_keys);
+            chip8_set_keypad(&chip8, host_keys);
 
             // execute one cycle
             chip8_execute_cycle(&chip8);
         }
 
+#ifdef CHIPIN_SHM
+        // publish before draw_flag is cleared (it marks the video as changed)
+        if (shm) {
+            chipin_shm_publish(shm, &chip8);
+        }
+#endif
+
+        // a misbehaving ROM only sets fault flags; report them and keep going
+        if (chip8.faults) {
+            chip8_report_faults(&chip8, stderr, "");
+        }
+
         // draw screen if needed
         if (chip8.draw_flag) {
             hal_draw_screen(chip8.video);
@@ -63,6 +118,11 @@ int main(int argc, char* argv[]) {
     }
 
     printf("Emulator shutting down...\n");
+#ifdef CHIPIN_SHM
+    if (shm) {
+        chipin_shm_destroy(shm, shm_name);
+    }
+#endif
     hal_cleanup();
     return 0;
 }
\ No newline at end of file
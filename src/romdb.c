@@ -0,0 +1,318 @@
+#include "romdb.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 64-bit FNV-1a
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+#define ROMDB_LINE_MAX 512
+
+// entries loaded from a text file (sorted by hash)
+static RomDbRecord_t* loaded = NULL;
+static size_t loaded_count = 0;
+
+static const struct {
+    const char* name;
+    uint8_t flag;
+} quirk_names[] = {
+    { "shift", QUIRK_SHIFT_VX },
+    { "memory", QUIRK_MEMORY_INC },
+    { "jump", QUIRK_JUMP_VX },
+    { "vfreset", QUIRK_VF_RESET },
+    { "wrap", QUIRK_WRAP },
+};
+
+uint64_t romdb_hash(const uint8_t* data, size_t size) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static const RomDbRecord_t* find_record(const RomDbRecord_t* table, size_t count, uint64_t hash) {
+    size_t low = 0;
+    size_t high = count;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (table[mid].hash < hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < count && table[low].hash == hash) {
+        return &table[low];
+    }
+    return NULL;
+}
+
+static void apply_record(const RomDbRecord_t* record, ChipInConfig_t* config) {
+    if (record->cycles_per_frame) {
+        config->cycles_per_frame = record->cycles_per_frame;
+    }
+
+    config->quirks = record->quirks;
+
+    if (record->scale) {
+        config->scale = record->scale;
+    }
+
+    // an all-black palette or an all-zero keymap means "not set"
+    bool has_palette = false;
+    for (int i = 0; i < 6; i++) {
+        has_palette |= record->palette[i] != 0;
+    }
+    if (has_palette) {
+        for (int i = 0; i < 2; i++) {
+            const uint8_t* rgb = &record->palette[i * 3];
+            config->palette[i] = ((uint32_t)rgb[0] << 24) | ((uint32_t)rgb[1] << 16) |
+                                 ((uint32_t)rgb[2] << 8) | 0xFF;
+        }
+    }
+
+    bool has_keymap = false;
+    for (int i = 0; i < NUM_KEYS / 2; i++) {
+        has_keymap |= record->keymap[i] != 0;
+    }
+    if (has_keymap) {
+        for (int i = 0; i < NUM_KEYS; i++) {
+            uint8_t packed = record->keymap[i / 2];
+            config->keymap[i] = (i % 2 == 0) ? packed >> 4 : packed & 0x0F;
+        }
+    }
+}
+
+bool romdb_lookup(uint64_t hash, ChipInConfig_t* config) {
+    const RomDbRecord_t* record = find_record(loaded, loaded_count, hash);
+    if (!record) {
+        record = find_record(romdb_builtin, romdb_builtin_count, hash);
+    }
+    if (!record) {
+        return false;
+    }
+
+    apply_record(record, config);
+    return true;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_rgb(const char* text, uint8_t* rgb) {
+    for (int i = 0; i < 6; i++) {
+        if (hex_value(text[i]) < 0) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        rgb[i] = (hex_value(text[i * 2]) << 4) | hex_value(text[i * 2 + 1]);
+    }
+    return true;
+}
+
+static bool parse_number(const char* text, unsigned long max, unsigned long* value) {
+    char* end;
+    errno = 0;
+    *value = strtoul(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && *value >= 1 && *value <= max;
+}
+
+static bool parse_field(const char* key, const char* value, RomDbRecord_t* record) {
+    unsigned long number;
+
+    if (strcmp(key, "cycles") == 0) {
+        if (!parse_number(value, 0xFFFF, &number)) {
+            return false;
+        }
+        record->cycles_per_frame = (uint16_t)number;
+    } else if (strcmp(key, "scale") == 0) {
+        if (!parse_number(value, 0xFF, &number)) {
+            return false;
+        }
+        record->scale = (uint8_t)number;
+    } else if (strcmp(key, "quirks") == 0) {
+        record->quirks = 0;
+        if (strcmp(value, "none") == 0) {
+            return true;
+        }
+
+        const char* name = value;
+        while (*name) {
+            size_t len = strcspn(name, ",");
+            bool known = false;
+            for (size_t i = 0; i < sizeof(quirk_names) / sizeof(quirk_names[0]); i++) {
+                if (strlen(quirk_names[i].name) == len && strncmp(name, quirk_names[i].name, len) == 0) {
+                    record->quirks |= quirk_names[i].flag;
+                    known = true;
+                }
+            }
+            if (!known) {
+                return false;
+            }
+            name += len;
+            if (*name == ',') {
+                name++;
+            }
+        }
+    } else if (strcmp(key, "palette") == 0) {
+        if (strlen(value) != 13 || value[6] != ',' ||
+            !parse_rgb(value, &record->palette[0]) ||
+            !parse_rgb(value + 7, &record->palette[3])) {
+            return false;
+        }
+    } else if (strcmp(key, "keys") == 0) {
+        if (strlen(value) != NUM_KEYS) {
+            return false;
+        }
+        for (int i = 0; i < NUM_KEYS; i++) {
+            int key_value = hex_value(value[i]);
+            if (key_value < 0) {
+                return false;
+            }
+            record->keymap[i / 2] |= (i % 2 == 0) ? key_value << 4 : key_value;
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+// returns 1 for an entry, 0 for a blank/comment line, -1 on a syntax error
+static int parse_line(char* line, RomDbRecord_t* record) {
+    char* comment = strchr(line, '#');
+    if (comment) {
+        *comment = '\0';
+    }
+
+    char* token = strtok(line, " \t\r\n");
+    if (!token) {
+        return 0;
+    }
+
+    memset(record, 0, sizeof(RomDbRecord_t));
+
+    // exactly 1-16 hex digits: no sign, no 0x prefix
+    size_t digits = strlen(token);
+    if (digits > 16) {
+        return -1;
+    }
+    for (size_t i = 0; i < digits; i++) {
+        int digit = hex_value(token[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        record->hash = (record->hash << 4) | (uint64_t)digit;
+    }
+
+    while ((token = strtok(NULL, " \t\r\n")) != NULL) {
+        char* value = strchr(token, '=');
+        if (!value) {
+            return -1;
+        }
+        *value++ = '\0';
+
+        if (!parse_field(token, value, record)) {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+static int compare_records(const void* a, const void* b) {
+    uint64_t left = ((const RomDbRecord_t*)a)->hash;
+    uint64_t right = ((const RomDbRecord_t*)b)->hash;
+    return (left > right) - (left < right);
+}
+
+bool romdb_load_file(const char* filename) {
+    FILE* db_file = fopen(filename, "r");
+    if (!db_file) {
+        if (errno != ENOENT) {
+            perror("Failed to open ROM database");
+        }
+        return false;
+    }
+
+    RomDbRecord_t* records = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    char line[ROMDB_LINE_MAX];
+    int line_number = 0;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), db_file)) {
+        line_number++;
+
+        RomDbRecord_t record;
+        int result = parse_line(line, &record);
+        if (result < 0) {
+            fprintf(stderr, "%s:%d: invalid ROM database entry\n", filename, line_number);
+            ok = false;
+            break;
+        }
+        if (result == 0) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 32;
+            RomDbRecord_t* grown = realloc(records, capacity * sizeof(RomDbRecord_t));
+            if (!grown) {
+                fprintf(stderr, "Out of memory loading ROM database.\n");
+                ok = false;
+                break;
+            }
+            records = grown;
+        }
+        records[count++] = record;
+    }
+
+    fclose(db_file);
+
+    if (!ok) {
+        free(records);
+        return false;
+    }
+
+    qsort(records, count, sizeof(RomDbRecord_t), compare_records);
+
+    // drop duplicate hashes so lookups stay unambiguous
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique > 0 && records[unique - 1].hash == records[i].hash) {
+            fprintf(stderr, "%s: duplicate entry for %016llx ignored\n",
+                    filename, (unsigned long long)records[i].hash);
+            continue;
+        }
+        records[unique++] = records[i];
+    }
+
+    romdb_unload();
+    loaded = records;
+    loaded_count = unique;
+    return true;
+}
+
+const RomDbRecord_t* romdb_entries(size_t* count) {
+    *count = loaded_count;
+    return loaded;
+}
+
+void romdb_unload(void) {
+    free(loaded);
+    loaded = NULL;
+    loaded_count = 0;
+}
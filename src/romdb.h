@@ -0,0 +1,43 @@
+#ifndef CHIPIN_ROMDB_H
+#define CHIPIN_ROMDB_H
+
+#include "chip8.h"
+
+// per-ROM configuration database, keyed by a 64-bit FNV-1a hash of the ROM.
+//
+// two sources are searched, in order:
+//   1. entries loaded at runtime from a text file (romdb_load_file)
+//   2. the table compiled into the binary (romdb_builtin.c), which is
+//      generated from the same text format by `chipin_romdb compile`
+//
+// text format, one ROM per line (every field after the hash is optional):
+//   <hash> cycles=15 quirks=shift,memory,jump,vfreset,wrap scale=8
+//          palette=RRGGBB,RRGGBB keys=0123456789ABCDEF   # comment
+//
+// `keys` gives, for host keys 0-F, the CHIP-8 key each one drives.
+
+// compact record: zero fields mean "keep the default"
+typedef struct {
+    uint64_t hash;
+    uint16_t cycles_per_frame;
+    uint8_t quirks;
+    uint8_t scale;
+    uint8_t palette[6];         // RGB background, RGB foreground
+    uint8_t keymap[NUM_KEYS / 2];  // host keys 2n/2n+1 in the high/low nibble
+} RomDbRecord_t;
+
+// built-in table (sorted by hash)
+extern const RomDbRecord_t romdb_builtin[];
+extern const size_t romdb_builtin_count;
+
+uint64_t romdb_hash(const uint8_t* data, size_t size);
+
+// apply the entry for `hash` to `config`; false if the ROM is unknown
+bool romdb_lookup(uint64_t hash, ChipInConfig_t* config);
+
+// load a text database; a missing file is not an error worth printing
+bool romdb_load_file(const char* filename);
+const RomDbRecord_t* romdb_entries(size_t* count);
+void romdb_unload(void);
+
+#endif //CHIPIN_ROMDB_H
@@ -0,0 +1,8 @@
+// generated from romdb.txt by `chipin_romdb compile` - do not edit
+#include "romdb.h"
+
+const RomDbRecord_t romdb_builtin[] = {
+    { 0x8a0f711093669ca5ULL, 12, 0x00, 0, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+};
+
+const size_t romdb_builtin_count = 1;
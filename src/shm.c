@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L  // shm_open, ftruncate
+
+#include "shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// how long chipin_shm_read keeps retrying before giving up (a publish takes
+// microseconds, so this only trips if the writer died mid-publish)
+#define SHM_READ_TIMEOUT_NS 100000000LL
+
+static int64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+ChipInShm_t* chipin_shm_create(const char* name) {
+    // O_EXCL: a second writer on a live segment would break the seqlock
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            fprintf(stderr, "Shared memory %s is already in use by another emulator "
+                            "(if it crashed, remove /dev/shm%s).\n", name, name);
+        } else {
+            perror("Failed to create shared memory");
+        }
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(ChipInShm_t)) != 0) {
+        perror("Failed to size shared memory");
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    void* mapping = mmap(NULL, sizeof(ChipInShm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the segment alive
+
+    if (mapping == MAP_FAILED) {
+        perror("Failed to map shared memory");
+        shm_unlink(name);
+        return NULL;
+    }
+
+    ChipInShm_t* shm = mapping;
+    memset(shm, 0, sizeof(ChipInShm_t));
+    shm->version = CHIPIN_SHM_VERSION;
+    shm->size = sizeof(ChipInShm_t);
+
+    // magic goes last so readers never see a half-initialized header
+    __atomic_store_n(&shm->magic, CHIPIN_SHM_MAGIC, __ATOMIC_RELEASE);
+    return shm;
+}
+
+void chipin_shm_publish(ChipInShm_t* shm, const ChipIn_t* cpu) {
+    uint32_t sequence = __atomic_load_n(&shm->sequence, __ATOMIC_RELAXED);
+
+    // odd sequence: readers that start now will retry
+    __atomic_store_n(&shm->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    ChipInShmFrame_t* state = &shm->state;
+    state->frame++;
+    state->pc = cpu->pc;
+    state->I = cpu->I;
+    memcpy(state->V, cpu->V, sizeof(state->V));
+    memcpy(state->stack, cpu->stack, sizeof(state->stack));
+    state->sp = cpu->sp;
+    state->delay_timer = cpu->delay_timer;
+    state->sound_timer = cpu->sound_timer;
+    memcpy(state->keypad, cpu->keypad, sizeof(state->keypad));
+    state->faults = cpu->faults;
+    memcpy(state->fault_pc, cpu->fault_pc, sizeof(state->fault_pc));
+
+    // video only changes on CLS/DRW, so skip the bulk copy otherwise
+    if (cpu->draw_flag) {
+        memcpy(state->video, cpu->video, sizeof(state->video));
+    }
+
+    __atomic_store_n(&shm->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+void chipin_shm_destroy(ChipInShm_t* shm, const char* name) {
+    if (shm) {
+        munmap(shm, sizeof(ChipInShm_t));
+    }
+    shm_unlink(name);
+}
+
+const ChipInShm_t* chipin_shm_attach(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        perror("Failed to open shared memory");
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(ChipInShm_t)) {
+        fprintf(stderr, "Shared memory segment is too small.\n");
+        close(fd);
+        return NULL;
+    }
+
+    void* mapping = mmap(NULL, sizeof(ChipInShm_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        perror("Failed to map shared memory");
+        return NULL;
+    }
+
+    const ChipInShm_t* shm = mapping;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != CHIPIN_SHM_MAGIC ||
+        shm->version != CHIPIN_SHM_VERSION ||
+        shm->size != sizeof(ChipInShm_t)) {
+        fprintf(stderr, "Shared memory segment has an unknown layout.\n");
+        munmap(mapping, sizeof(ChipInShm_t));
+        return NULL;
+    }
+
+    return shm;
+}
+
+void chipin_shm_detach(const ChipInShm_t* shm) {
+    if (shm) {
+        munmap((void*)shm, sizeof(ChipInShm_t));
+    }
+}
+
+uint32_t chipin_shm_read_begin(const ChipInShm_t* shm) {
+    return __atomic_load_n(&shm->sequence, __ATOMIC_ACQUIRE);
+}
+
+bool chipin_shm_read_retry(const ChipInShm_t* shm, uint32_t sequence) {
+    // keep the snapshot reads above from sinking below the re-check
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (sequence & 1) || __atomic_load_n(&shm->sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+bool chipin_shm_read(const ChipInShm_t* shm, ChipInShmFrame_t* out) {
+    int64_t deadline = 0;
+
+    for (;;) {
+        uint32_t sequence = chipin_shm_read_begin(shm);
+        if (!(sequence & 1)) {
+            memcpy(out, &shm->state, sizeof(ChipInShmFrame_t));
+
+            if (!chipin_shm_read_retry(shm, sequence)) {
+                return true;
+            }
+        }
+
+        // raced with a publish: let the writer finish instead of spinning on it
+        int64_t now = monotonic_ns();
+        if (deadline == 0) {
+            deadline = now + SHM_READ_TIMEOUT_NS;
+        } else if (now >= deadline) {
+            return false;
+        }
+        sched_yield();
+    }
+}
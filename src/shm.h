@@ -0,0 +1,66 @@
+#ifndef CHIPIN_SHM_H
+#define CHIPIN_SHM_H
+
+#include "chip8.h"
+
+// shared-memory export of the VM state (POSIX only).
+//
+// the emulator publishes one snapshot per frame into a named segment
+// (e.g. "/chipin"); any number of local processes can attach read-only.
+// a seqlock guards the snapshot: the writer never waits for readers, and
+// readers retry if they raced with a publish.
+//
+// publishing is a synchronous copy on the emulator thread (registers every
+// frame, the framebuffer when draw_flag is set); only reads are zero-copy.
+
+#define CHIPIN_SHM_MAGIC 0x50494843u  // "CHIP" in memory order
+#define CHIPIN_SHM_VERSION 3
+
+// VM state as seen by readers
+typedef struct {
+    uint32_t frame;             // incremented on every publish
+    uint16_t pc;
+    uint16_t I;
+    uint8_t V[NUM_REGISTERS];
+    uint16_t stack[STACK_DEPTH];
+    uint8_t sp;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t keypad[NUM_KEYS];
+    uint8_t faults;             // FAULT_* flags raised since the last publish
+    uint16_t fault_pc[FAULT_COUNT]; // per flag: address of the last instruction that raised it
+    uint32_t video[VIDEO_WIDTH * VIDEO_HEIGHT];
+} ChipInShmFrame_t;
+
+// segment layout
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;              // sizeof(ChipInShm_t) of the writer
+    uint32_t sequence;          // seqlock: odd while a publish is in progress
+    ChipInShmFrame_t state;
+} ChipInShm_t;
+
+// write side (emulator)
+ChipInShm_t* chipin_shm_create(const char* name);
+void chipin_shm_publish(ChipInShm_t* shm, const ChipIn_t* cpu);
+void chipin_shm_destroy(ChipInShm_t* shm, const char* name);
+
+// read side (external consumers)
+const ChipInShm_t* chipin_shm_attach(const char* name);
+void chipin_shm_detach(const ChipInShm_t* shm);
+
+// copy a consistent snapshot, yielding while a publish is in progress;
+// false only if no consistent snapshot appeared within ~100ms
+bool chipin_shm_read(const ChipInShm_t* shm, ChipInShmFrame_t* out);
+
+// zero-copy reads straight from the segment:
+//     uint32_t seq;
+//     do {
+//         seq = chipin_shm_read_begin(shm);
+//         ... read shm->state ...
+//     } while (chipin_shm_read_retry(shm, seq));
+uint32_t chipin_shm_read_begin(const ChipInShm_t* shm);
+bool chipin_shm_read_retry(const ChipInShm_t* shm, uint32_t sequence);
+
+#endif //CHIPIN_SHM_H
@@ -0,0 +1,24 @@
+#ifndef CHIPIN_TEST_ROM_H
+#define CHIPIN_TEST_ROM_H
+
+#include <stdint.h>
+
+// built-in ROM run by the Pico build (shared with the ROM database check,
+// which makes sure data/romdb.txt still has an entry for it)
+static const uint8_t test_rom[] = {
+    0xA2, 0x2A, // LD I, 0x22A (point to sprite data)
+    0x60, 0x0C, // LD V0, 0x0C (X position)
+    0x61, 0x08, // LD V1, 0x08 (Y position)
+    0xD0, 0x1F, // DRW V0, V1, 15 (draw sprite)
+    0x12, 0x00, // JP 0x200 (infinite loop)
+
+    // sprite data (simple pattern)
+    0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+    0x20, 0x60, 0x20, 0x20, 0x70, // 1
+    0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+};
+
+// what the built-in database entry sets for this ROM
+#define TEST_ROM_CYCLES_PER_FRAME 12
+
+#endif //CHIPIN_TEST_ROM_H